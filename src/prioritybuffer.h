@@ -10,43 +10,45 @@
 #include <memory>
 #include <mutex>
 #include <random>
-#include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "prioritydb.h"
 #include "priorityfs.h"
+#include "prioritymemoryindex.h"
+#include "prioritysequence.h"
 
 #define DEFAULT_MAX_BUFFER_SIZE 100000000LL
 #define DEFAULT_MAX_MEMORY_SIZE 50
 
 
-template <typename T>
+// Index selects where the priority bookkeeping lives. It must implement PriorityIndex and provide
+// a static FileName() naming its file inside the buffer directory: PriorityDB keeps it in SQLite,
+// PriorityMemoryIndex keeps it in process.
+template <typename T, typename Index=PriorityDB>
 class PriorityBuffer {
     typedef std::function<unsigned long long(const T&)> PriorityFunction;
 
   public:
     PriorityBuffer()
             : make_priority_{epoch_priority_}, fs_{"prism_buffer", std::string{}},
-              db_{DEFAULT_MAX_BUFFER_SIZE, fs_.GetFilePath("prism_data.db")},
-              max_memory_{DEFAULT_MAX_MEMORY_SIZE}, fuzzer_{0, 0} {
-        srand(std::chrono::steady_clock::now().time_since_epoch().count());
-    }
+              db_{DEFAULT_MAX_BUFFER_SIZE, fs_.GetFilePath(Index::FileName())},
+              sequence_{fs_.GetFilePath(PrioritySequence::FileName())},
+              max_memory_{DEFAULT_MAX_MEMORY_SIZE}, fuzzer_{0, 0} {}
 
     PriorityBuffer(PriorityFunction make_priority)
             : make_priority_{make_priority}, fs_{"prism_buffer", std::string{}},
-              db_{DEFAULT_MAX_BUFFER_SIZE, fs_.GetFilePath("prism_data.db")},
-              max_memory_{DEFAULT_MAX_MEMORY_SIZE}, fuzzer_{0, 0} {
-        srand(std::chrono::steady_clock::now().time_since_epoch().count());
-    }
+              db_{DEFAULT_MAX_BUFFER_SIZE, fs_.GetFilePath(Index::FileName())},
+              sequence_{fs_.GetFilePath(PrioritySequence::FileName())},
+              max_memory_{DEFAULT_MAX_MEMORY_SIZE}, fuzzer_{0, 0} {}
 
     PriorityBuffer(PriorityFunction make_priority, const unsigned long long& buffer_size,
                    const int& max_memory)
             : make_priority_{make_priority}, fs_{"prism_buffer", std::string{}},
-              db_{buffer_size, fs_.GetFilePath("prism_data.db")}, max_memory_{max_memory}, 
-              fuzzer_{0, 0} {
-        srand(std::chrono::steady_clock::now().time_since_epoch().count());
-    }
+              db_{buffer_size, fs_.GetFilePath(Index::FileName())},
+              sequence_{fs_.GetFilePath(PrioritySequence::FileName())}, max_memory_{max_memory},
+              fuzzer_{0, 0} {}
 
     ~PriorityBuffer() {
         for (auto object = objects_.begin(); object != objects_.end(); ++object) {
@@ -61,30 +63,35 @@ class PriorityBuffer {
     }
 
     void Push(std::unique_ptr<T> t) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto hash = make_hash_();
-        auto t_ptr = t.get();
-        objects_[hash] = std::move(t);
-        auto size = get_size_(*t_ptr);
-        db_.Insert(make_priority_(*t_ptr), hash, size);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Transaction transaction{db_};
+            insert_(std::move(t));
+            evict_();
+            transaction.Commit();
+        }
 
-        while (objects_.size() > max_memory_) {
-            auto lowest_hash = db_.GetLowestMemoryHash();
-            auto find = objects_.find(lowest_hash);
-            if (find != objects_.end()) {
-                auto object = std::move(find->second);
-                save_to_disk(*(object.get()), lowest_hash);
-                objects_.erase(lowest_hash);
-            }
+        condition_.notify_one();
+    }
+
+    // Pushes every object under a single lock and a single index transaction, then evicts and
+    // spills whatever no longer fits in one pass
+    void PushBatch(std::vector<std::unique_ptr<T>> ts) {
+        if (ts.empty()) {
+            return;
         }
 
-        while (db_.Full()) {
-            auto lowest_hash = db_.GetLowestDiskHash();
-            fs_.Delete(lowest_hash);
-            db_.Delete(lowest_hash);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            Transaction transaction{db_};
+            for (auto& t : ts) {
+                insert_(std::move(t));
+            }
+            evict_();
+            transaction.Commit();
         }
 
-        condition_.notify_one();;
+        condition_.notify_all();
     }
 
     std::unique_ptr<T> Pop(bool block=false) {
@@ -95,7 +102,7 @@ class PriorityBuffer {
             bool on_disk;
             auto hash = db_.GetHighestHash(on_disk);
             if (block) {
-                while (hash.empty()) {
+                while (hash == 0) {
                     condition_.wait(lock);
                     hash = db_.GetHighestHash(on_disk);
                 }
@@ -122,57 +129,101 @@ class PriorityBuffer {
     }
 
   private:
-    static unsigned long long epoch_priority_(const T& t) {
-        return std::chrono::steady_clock::now().time_since_epoch().count();
-    }
+    // Commits on scope exit too, so the index is never left holding a transaction open when an
+    // exception escapes. Whatever was written before the exception stays written.
+    class Transaction {
+      public:
+        Transaction(Index& db) : db_(db), committed_{false} {
+            db_.Begin();
+        }
 
-    static std::string make_hash_(const int& len=32) {
-        static const char alphanum[] = "0123456789"
-                                       "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                                       "abcdefghijklmnopqrstuvwxyz";
+        ~Transaction() {
+            if (!committed_) {
+                try {
+                    db_.Commit();
+                } catch (...) {}
+            }
+        }
 
-        std::stringstream stream;
-        for (int i = 0; i < len; ++i) {
-            stream << alphanum[rand() % (sizeof(alphanum) - 1)];
+        void Commit() {
+            committed_ = true;
+            db_.Commit();
         }
 
-        return stream.str();
+      private:
+        Index& db_;
+        bool committed_;
+    };
+
+    static unsigned long long epoch_priority_(const T& t) {
+        return std::chrono::steady_clock::now().time_since_epoch().count();
     }
 
     static unsigned long get_size_(const T& t) {
         return t.ByteSize();
     }
 
-    std::unique_ptr<T> inflate(const std::string& hash) {
+    void insert_(std::unique_ptr<T> t) {
+        auto hash = sequence_.Next();
+        auto t_ptr = t.get();
+        objects_[hash] = std::move(t);
+        auto size = get_size_(*t_ptr);
+        db_.Insert(make_priority_(*t_ptr), hash, size);
+    }
+
+    void evict_() {
+        while (objects_.size() > max_memory_) {
+            auto lowest_hashes = db_.GetLowestMemoryHashes(objects_.size() - max_memory_);
+            for (auto& lowest_hash : lowest_hashes) {
+                auto find = objects_.find(lowest_hash);
+                if (find != objects_.end()) {
+                    auto object = std::move(find->second);
+                    save_to_disk(*(object.get()), lowest_hash);
+                    objects_.erase(find);
+                }
+            }
+        }
+
+        while (db_.Full()) {
+            auto lowest_hash = db_.GetLowestDiskHash();
+            fs_.Delete(std::to_string(lowest_hash));
+            db_.Delete(lowest_hash);
+        }
+    }
+
+    std::unique_ptr<T> inflate(const unsigned long long& hash) {
         std::ifstream file_stream;
-        if (fs_.GetInput(hash, file_stream) && file_stream.is_open()) {
+        auto file = std::to_string(hash);
+        if (fs_.GetInput(file, file_stream) && file_stream.is_open()) {
             auto t = std::unique_ptr<T>{ new T{} };
             t->ParseFromIstream(&file_stream);
             t->CheckInitialized();
             file_stream.close();
-            fs_.Delete(hash);
+            fs_.Delete(file);
             return t;
         }
         return nullptr;
     }
 
-    bool save_to_disk(const T& t, const std::string& hash) {
+    bool save_to_disk(const T& t, const unsigned long long& hash) {
         std::ofstream file_stream;
-        if (fs_.GetOutput(hash, file_stream) && file_stream.is_open()) {
+        auto file = std::to_string(hash);
+        if (fs_.GetOutput(file, file_stream) && file_stream.is_open()) {
             t.SerializeToOstream(&file_stream);
             file_stream.close();
             db_.Update(hash, true);
             return true;
         }
-        fs_.Delete(hash);
+        fs_.Delete(file);
         db_.Delete(hash);
         return false;
     }
 
     PriorityFS fs_;
-    PriorityDB db_;
+    Index db_;
+    PrioritySequence sequence_;
     PriorityFunction make_priority_;
-    std::map<std::string, std::unique_ptr<T>> objects_;
+    std::map<unsigned long long, std::unique_ptr<T>> objects_;
     std::mutex mutex_;
     std::condition_variable condition_;
     int max_memory_;
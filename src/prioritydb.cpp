@@ -5,6 +5,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <sqlite3.h>
@@ -13,167 +14,226 @@
 class PriorityDB::Impl {
   public:
     Impl(const unsigned long long& max_size, const std::string& path)
-            : max_size_{max_size}, table_path_{path}, table_name_{"prism_data"} {
+            : max_size_{max_size}, table_path_{path}, table_name_{"prism_data"},
+              memory_bytes_{0}, disk_bytes_{0}, memory_count_{0}, disk_count_{0},
+              transaction_depth_{0} {
         if (max_size_ == 0LL) {
             throw PriorityDBException{"Must specify a nonzero max_size"};
         }
+        db_ = open_db_();
         if (!check_table_()) {
             create_table_();
+        } else {
+            upgrade_table_();
         }
+        create_indices_();
+        prepare_statements_();
+        load_totals_();
     }
 
-    void Insert(const unsigned long long& priority, const std::string& hash,
+    void Insert(const unsigned long long& priority, const unsigned long long& hash,
                 const unsigned long long& size, const bool& on_disk);
-    void Delete(const std::string& hash);
-    void Update(const std::string& hash, const bool& on_disk);
-    std::string GetHighestHash(bool& on_disk);
-    std::string GetLowestMemoryHash();
-    std::string GetLowestDiskHash();
+    void Delete(const unsigned long long& hash);
+    void Update(const unsigned long long& hash, const bool& on_disk);
+    unsigned long long GetHighestHash(bool& on_disk);
+    unsigned long long GetLowestMemoryHash();
+    std::vector<unsigned long long> GetLowestMemoryHashes(const unsigned long long& count);
+    unsigned long long GetLowestDiskHash();
     bool Full();
+    unsigned long long DiskBytes();
+    unsigned long long MemoryBytes();
+    unsigned long long Count();
+    void Begin();
+    void Commit();
 
   private:
     typedef std::map<std::string, std::string> Record;
+    typedef std::unique_ptr<sqlite3_stmt, std::function<int(sqlite3_stmt*)>> Statement;
 
     std::unique_ptr<sqlite3, std::function<int(sqlite3*)>> open_db_();
     bool check_table_();
     void create_table_();
+    void upgrade_table_();
+    void create_indices_();
+    void prepare_statements_();
+    void load_totals_();
+    void add_to_totals_(const unsigned long long& size, const bool& on_disk);
+    void remove_from_totals_(const unsigned long long& size, const bool& on_disk);
+    Statement prepare_(const std::string& sql);
+    bool step_(const Statement& statement);
+    void reset_(const Statement& statement);
     std::vector<Record> execute_(const std::string& sql);
     static int callback_(void* response_ptr, int num_values, char** values, char** names);
 
     std::string table_path_;
     std::string table_name_;
     unsigned long long max_size_;
+
+    // Running totals, kept in step with every write so that Full() and the accessors never have
+    // to scan the table
+    unsigned long long memory_bytes_;
+    unsigned long long disk_bytes_;
+    unsigned long long memory_count_;
+    unsigned long long disk_count_;
+
+    unsigned long long transaction_depth_;
+
+    // The connection is declared before the statements so that every statement is finalized
+    // before the connection is closed
+    std::unique_ptr<sqlite3, std::function<int(sqlite3*)>> db_;
+    Statement insert_statement_;
+    Statement delete_statement_;
+    Statement update_statement_;
+    Statement highest_statement_;
+    Statement lowest_memory_statement_;
+    Statement lowest_memory_batch_statement_;
+    Statement lowest_disk_statement_;
+    Statement select_statement_;
+    Statement begin_statement_;
+    Statement commit_statement_;
 };
 
-void PriorityDB::Impl::Insert(const unsigned long long& priority, const std::string& hash,
+void PriorityDB::Impl::Insert(const unsigned long long& priority, const unsigned long long& hash,
                               const unsigned long long& size, const bool& on_disk) {
-    if (hash.empty()) {
+    if (hash == 0) {
         return;
     }
 
-    std::stringstream stream;
-    stream << "INSERT INTO "
-           << table_name_
-           << "(priority, hash, size, on_disk)"
-           << "VALUES"
-           << "("
-           << priority << ","
-           << "'" << hash << "',"
-           << size << ","
-           << on_disk
-           << ");";
-    execute_(stream.str());
+    sqlite3_bind_int64(insert_statement_.get(), 1, priority);
+    sqlite3_bind_int64(insert_statement_.get(), 2, hash);
+    sqlite3_bind_int64(insert_statement_.get(), 3, size);
+    sqlite3_bind_int(insert_statement_.get(), 4, on_disk);
+    step_(insert_statement_);
+    reset_(insert_statement_);
+    add_to_totals_(size, on_disk);
 }
 
-void PriorityDB::Impl::Delete(const std::string& hash) {
-    if (hash.empty()) {
+void PriorityDB::Impl::Delete(const unsigned long long& hash) {
+    if (hash == 0) {
         return;
     }
 
-    std::stringstream stream;
-    stream << "DELETE FROM "
-           << table_name_
-           << " WHERE hash='"
-           << hash
-           << "';";
-    execute_(stream.str());
+    std::vector<std::pair<unsigned long long, bool>> rows;
+    sqlite3_bind_int64(select_statement_.get(), 1, hash);
+    while (step_(select_statement_)) {
+        rows.emplace_back(sqlite3_column_int64(select_statement_.get(), 0),
+                          sqlite3_column_int(select_statement_.get(), 1));
+    }
+    reset_(select_statement_);
+
+    sqlite3_bind_int64(delete_statement_.get(), 1, hash);
+    step_(delete_statement_);
+    reset_(delete_statement_);
+    for (auto& row : rows) {
+        remove_from_totals_(row.first, row.second);
+    }
 }
 
-void PriorityDB::Impl::Update(const std::string& hash, const bool& on_disk) {
-    if (hash.empty()) {
+void PriorityDB::Impl::Update(const unsigned long long& hash, const bool& on_disk) {
+    if (hash == 0) {
         return;
     }
 
-    std::stringstream stream;
-    stream << "UPDATE "
-           << table_name_
-           << " SET on_disk="
-           << on_disk
-           << " WHERE hash='"
-           << hash
-           << "';";
-    execute_(stream.str());
+    std::vector<std::pair<unsigned long long, bool>> rows;
+    sqlite3_bind_int64(select_statement_.get(), 1, hash);
+    while (step_(select_statement_)) {
+        rows.emplace_back(sqlite3_column_int64(select_statement_.get(), 0),
+                          sqlite3_column_int(select_statement_.get(), 1));
+    }
+    reset_(select_statement_);
+
+    sqlite3_bind_int(update_statement_.get(), 1, on_disk);
+    sqlite3_bind_int64(update_statement_.get(), 2, hash);
+    step_(update_statement_);
+    reset_(update_statement_);
+    for (auto& row : rows) {
+        remove_from_totals_(row.first, row.second);
+        add_to_totals_(row.first, on_disk);
+    }
 }
 
-std::string PriorityDB::Impl::GetHighestHash(bool& on_disk) {
-    std::stringstream stream;
-    stream << "SELECT hash, on_disk FROM "
-           << table_name_
-           << " ORDER BY priority DESC, on_disk ASC LIMIT 1;";
-    auto response = execute_(stream.str());
-    std::string hash;
-    if (!response.empty()) {
-        auto record = response[0];
-        if (!record.empty()) {
-            hash = record["hash"];
-            on_disk = std::stoi(record["on_disk"]);
-        }
+unsigned long long PriorityDB::Impl::GetHighestHash(bool& on_disk) {
+    unsigned long long hash = 0;
+    if (step_(highest_statement_)) {
+        hash = sqlite3_column_int64(highest_statement_.get(), 0);
+        on_disk = sqlite3_column_int(highest_statement_.get(), 1);
     }
+    reset_(highest_statement_);
 
     return hash;
 }
 
-std::string PriorityDB::Impl::GetLowestMemoryHash() {
-    std::stringstream stream;
-    stream << "SELECT hash FROM "
-           << table_name_
-           << " WHERE on_disk="
-           << false
-           << " ORDER BY priority ASC LIMIT 1;";
-    auto response = execute_(stream.str());
-    std::string hash;
-    if (!response.empty()) {
-        auto record = response[0];
-        if (!record.empty()) {
-            hash = record["hash"];
-        }
+unsigned long long PriorityDB::Impl::GetLowestMemoryHash() {
+    unsigned long long hash = 0;
+    if (step_(lowest_memory_statement_)) {
+        hash = sqlite3_column_int64(lowest_memory_statement_.get(), 0);
     }
+    reset_(lowest_memory_statement_);
 
     return hash;
 }
 
-std::string PriorityDB::Impl::GetLowestDiskHash() {
-    std::stringstream stream;
-    stream << "SELECT hash FROM "
-           << table_name_
-           << " WHERE on_disk="
-           << true
-           << " ORDER BY priority ASC LIMIT 1;";
-    auto response = execute_(stream.str());
-    std::string hash;
-    if (!response.empty()) {
-        auto record = response[0];
-        if (!record.empty()) {
-            hash = record["hash"];
-        }
+std::vector<unsigned long long> PriorityDB::Impl::GetLowestMemoryHashes(
+        const unsigned long long& count) {
+    std::vector<unsigned long long> hashes;
+    sqlite3_bind_int64(lowest_memory_batch_statement_.get(), 1, count);
+    while (step_(lowest_memory_batch_statement_)) {
+        hashes.push_back(sqlite3_column_int64(lowest_memory_batch_statement_.get(), 0));
+    }
+    reset_(lowest_memory_batch_statement_);
+
+    return hashes;
+}
+
+unsigned long long PriorityDB::Impl::GetLowestDiskHash() {
+    unsigned long long hash = 0;
+    if (step_(lowest_disk_statement_)) {
+        hash = sqlite3_column_int64(lowest_disk_statement_.get(), 0);
     }
+    reset_(lowest_disk_statement_);
 
     return hash;
 }
 
 bool PriorityDB::Impl::Full() {
-    std::stringstream stream;
-    stream << "SELECT SUM(size) FROM "
-           << table_name_
-           << " WHERE on_disk="
-           << true
-           << ";";
-    auto response = execute_(stream.str());
-    unsigned long long total = 0;
-    if (!response.empty()) {
-        auto record = response[0];
-        if (!record.empty()) {
-            total = std::stoi(record["SUM(size)"]);
-        }
+    return disk_bytes_ > max_size_;
+}
+
+unsigned long long PriorityDB::Impl::DiskBytes() {
+    return disk_bytes_;
+}
+
+unsigned long long PriorityDB::Impl::MemoryBytes() {
+    return memory_bytes_;
+}
+
+unsigned long long PriorityDB::Impl::Count() {
+    return memory_count_ + disk_count_;
+}
+
+void PriorityDB::Impl::Begin() {
+    if (transaction_depth_++ == 0) {
+        step_(begin_statement_);
+        reset_(begin_statement_);
     }
+}
 
-    return total > max_size_;
+void PriorityDB::Impl::Commit() {
+    if (transaction_depth_ == 0) {
+        return;
+    }
+    if (--transaction_depth_ == 0) {
+        step_(commit_statement_);
+        reset_(commit_statement_);
+    }
 }
 
 std::unique_ptr<sqlite3, std::function<int(sqlite3*)>> PriorityDB::Impl::open_db_() {
     sqlite3* sqlite_db;
     if (sqlite3_open(table_path_.data(), &sqlite_db) != SQLITE_OK) {
-        throw PriorityDBException{sqlite3_errmsg(sqlite_db)};
+        auto error_string = std::string{sqlite3_errmsg(sqlite_db)};
+        sqlite3_close(sqlite_db);
+        throw PriorityDBException{error_string};
     }
     return std::unique_ptr<sqlite3, std::function<int(sqlite3*)>>(sqlite_db, sqlite3_close);
 }
@@ -195,18 +255,203 @@ void PriorityDB::Impl::create_table_() {
            << "("
            << "id INTEGER PRIMARY KEY AUTOINCREMENT,"
            << "priority UNSIGNED BIGINT NOT NULL,"
-           << "hash TEXT NOT NULL,"
+           << "hash INTEGER NOT NULL,"
            << "size UNSIGNED BIGINT NOT NULL,"
            << "on_disk BOOL NOT NULL"
            << ");";
     execute_(stream.str());
 }
 
+void PriorityDB::Impl::upgrade_table_() {
+    // Tables from before sequence IDs declared hash as TEXT and filled it with random strings.
+    // Integer IDs still work against that column through type affinity, but the old rows can
+    // never be looked up by ID again, so drop them
+    std::stringstream stream;
+    stream << "PRAGMA table_info("
+           << table_name_
+           << ");";
+    auto response = execute_(stream.str());
+    for (auto& record : response) {
+        if (record["name"] == "hash" && record["type"] == "TEXT") {
+            std::stringstream stream;
+            stream << "DELETE FROM "
+                   << table_name_
+                   << " WHERE hash='' OR hash GLOB '*[^0-9]*';";
+            execute_(stream.str());
+        }
+    }
+}
+
+void PriorityDB::Impl::create_indices_() {
+    // IF NOT EXISTS lets this double as the upgrade step for tables created before the indices
+    {
+        std::stringstream stream;
+        stream << "CREATE INDEX IF NOT EXISTS "
+               << table_name_ << "_priority_index ON "
+               << table_name_
+               << "(on_disk, priority);";
+        execute_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "CREATE INDEX IF NOT EXISTS "
+               << table_name_ << "_hash_index ON "
+               << table_name_
+               << "(hash);";
+        execute_(stream.str());
+    }
+}
+
+void PriorityDB::Impl::prepare_statements_() {
+    {
+        std::stringstream stream;
+        stream << "INSERT INTO "
+               << table_name_
+               << "(priority, hash, size, on_disk)"
+               << "VALUES"
+               << "(?, ?, ?, ?);";
+        insert_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "DELETE FROM "
+               << table_name_
+               << " WHERE hash=?;";
+        delete_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "UPDATE "
+               << table_name_
+               << " SET on_disk=?"
+               << " WHERE hash=?;";
+        update_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        // Take the best candidate from each tier separately so both halves are answered by the
+        // (on_disk, priority) index, then pick between the two
+        stream << "SELECT hash, on_disk FROM ("
+               << "SELECT * FROM (SELECT hash, priority, on_disk FROM "
+               << table_name_
+               << " WHERE on_disk="
+               << false
+               << " ORDER BY priority DESC LIMIT 1)"
+               << " UNION ALL "
+               << "SELECT * FROM (SELECT hash, priority, on_disk FROM "
+               << table_name_
+               << " WHERE on_disk="
+               << true
+               << " ORDER BY priority DESC LIMIT 1)"
+               << ") ORDER BY priority DESC, on_disk ASC LIMIT 1;";
+        highest_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "SELECT hash FROM "
+               << table_name_
+               << " WHERE on_disk="
+               << false
+               << " ORDER BY priority ASC LIMIT 1;";
+        lowest_memory_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "SELECT hash FROM "
+               << table_name_
+               << " WHERE on_disk="
+               << false
+               << " ORDER BY priority ASC LIMIT ?;";
+        lowest_memory_batch_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "SELECT hash FROM "
+               << table_name_
+               << " WHERE on_disk="
+               << true
+               << " ORDER BY priority ASC LIMIT 1;";
+        lowest_disk_statement_ = prepare_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "SELECT size, on_disk FROM "
+               << table_name_
+               << " WHERE hash=?;";
+        select_statement_ = prepare_(stream.str());
+    }
+    begin_statement_ = prepare_("BEGIN;");
+    commit_statement_ = prepare_("COMMIT;");
+}
+
+void PriorityDB::Impl::load_totals_() {
+    std::stringstream stream;
+    stream << "SELECT on_disk, COUNT(*), SUM(size) FROM "
+           << table_name_
+           << " GROUP BY on_disk;";
+    auto response = execute_(stream.str());
+    for (auto& record : response) {
+        auto count = std::stoull(record["COUNT(*)"]);
+        auto bytes = std::stoull(record["SUM(size)"]);
+        if (std::stoi(record["on_disk"])) {
+            disk_count_ = count;
+            disk_bytes_ = bytes;
+        } else {
+            memory_count_ = count;
+            memory_bytes_ = bytes;
+        }
+    }
+}
+
+void PriorityDB::Impl::add_to_totals_(const unsigned long long& size, const bool& on_disk) {
+    if (on_disk) {
+        disk_bytes_ += size;
+        ++disk_count_;
+    } else {
+        memory_bytes_ += size;
+        ++memory_count_;
+    }
+}
+
+void PriorityDB::Impl::remove_from_totals_(const unsigned long long& size, const bool& on_disk) {
+    if (on_disk) {
+        disk_bytes_ -= size;
+        --disk_count_;
+    } else {
+        memory_bytes_ -= size;
+        --memory_count_;
+    }
+}
+
+PriorityDB::Impl::Statement PriorityDB::Impl::prepare_(const std::string& sql) {
+    sqlite3_stmt* statement;
+    if (sqlite3_prepare_v2(db_.get(), sql.data(), sql.size(), &statement, nullptr) != SQLITE_OK) {
+        throw PriorityDBException{sqlite3_errmsg(db_.get())};
+    }
+    return Statement(statement, sqlite3_finalize);
+}
+
+bool PriorityDB::Impl::step_(const Statement& statement) {
+    int rc = sqlite3_step(statement.get());
+    if (rc == SQLITE_ROW) {
+        return true;
+    } else if (rc != SQLITE_DONE) {
+        auto error_string = std::string{sqlite3_errmsg(db_.get())};
+        reset_(statement);
+        throw PriorityDBException{error_string};
+    }
+    return false;
+}
+
+void PriorityDB::Impl::reset_(const Statement& statement) {
+    sqlite3_reset(statement.get());
+    sqlite3_clear_bindings(statement.get());
+}
+
 std::vector<PriorityDB::Impl::Record> PriorityDB::Impl::execute_(const std::string& sql) {
     std::vector<Record> response;
-    auto db = open_db_();
     char* error;
-    int rc = sqlite3_exec(db.get(), sql.data(), &PriorityDB::Impl::callback_, &response, &error);
+    int rc = sqlite3_exec(db_.get(), sql.data(), &PriorityDB::Impl::callback_, &response, &error);
     if (rc != SQLITE_OK) {
         auto error_string = std::string{error};
         sqlite3_free(error);
@@ -237,31 +482,56 @@ PriorityDB::PriorityDB(const unsigned long long& max_size, const std::string& pa
         : pimpl_{ new Impl{max_size, path} } {}
 PriorityDB::~PriorityDB() {}
 
-void PriorityDB::Insert(const unsigned long long& priority, const std::string& hash,
+void PriorityDB::Insert(const unsigned long long& priority, const unsigned long long& hash,
                         const unsigned long long& size, const bool& on_disk) {
     pimpl_->Insert(priority, hash, size, on_disk);
 }
 
-void PriorityDB::Delete(const std::string& hash) {
+void PriorityDB::Delete(const unsigned long long& hash) {
     pimpl_->Delete(hash);
 }
 
-void PriorityDB::Update(const std::string& hash, const bool& on_disk) {
+void PriorityDB::Update(const unsigned long long& hash, const bool& on_disk) {
     pimpl_->Update(hash, on_disk);
 }
 
-std::string PriorityDB::GetHighestHash(bool& on_disk) {
+unsigned long long PriorityDB::GetHighestHash(bool& on_disk) {
     return pimpl_->GetHighestHash(on_disk);
 }
 
-std::string PriorityDB::GetLowestMemoryHash() {
+unsigned long long PriorityDB::GetLowestMemoryHash() {
     return pimpl_->GetLowestMemoryHash();
 }
 
-std::string PriorityDB::GetLowestDiskHash() {
+std::vector<unsigned long long> PriorityDB::GetLowestMemoryHashes(
+        const unsigned long long& count) {
+    return pimpl_->GetLowestMemoryHashes(count);
+}
+
+unsigned long long PriorityDB::GetLowestDiskHash() {
     return pimpl_->GetLowestDiskHash();
 }
 
 bool PriorityDB::Full() {
     return pimpl_->Full();
 }
+
+unsigned long long PriorityDB::DiskBytes() {
+    return pimpl_->DiskBytes();
+}
+
+unsigned long long PriorityDB::MemoryBytes() {
+    return pimpl_->MemoryBytes();
+}
+
+unsigned long long PriorityDB::Count() {
+    return pimpl_->Count();
+}
+
+void PriorityDB::Begin() {
+    pimpl_->Begin();
+}
+
+void PriorityDB::Commit() {
+    pimpl_->Commit();
+}
@@ -3,21 +3,35 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "priorityindex.h"
 
-class PriorityDB {
+
+class PriorityDB : public PriorityIndex {
   public:
     PriorityDB(const unsigned long long& max_size, const std::string& path);
     ~PriorityDB();
 
-    void Insert(const unsigned long long& priority, const std::string& hash,
-                const unsigned long long& size, const bool& on_disk=false);
-    void Delete(const std::string& hash);
-    void Update(const std::string& hash, const bool& on_disk);
-    std::string GetHighestHash(bool& on_disk);
-    std::string GetLowestMemoryHash();
-    std::string GetLowestDiskHash();
-    bool Full();
+    static std::string FileName() {
+        return "prism_data.db";
+    }
+
+    void Insert(const unsigned long long& priority, const unsigned long long& hash,
+                const unsigned long long& size, const bool& on_disk=false) override;
+    void Delete(const unsigned long long& hash) override;
+    void Update(const unsigned long long& hash, const bool& on_disk) override;
+    unsigned long long GetHighestHash(bool& on_disk) override;
+    unsigned long long GetLowestMemoryHash() override;
+    std::vector<unsigned long long> GetLowestMemoryHashes(
+            const unsigned long long& count) override;
+    unsigned long long GetLowestDiskHash() override;
+    bool Full() override;
+    unsigned long long DiskBytes() override;
+    unsigned long long MemoryBytes() override;
+    unsigned long long Count() override;
+    void Begin() override;
+    void Commit() override;
 
   private:
     class Impl;
@@ -0,0 +1,37 @@
+#ifndef PRIORITY_INDEX_H
+#define PRIORITY_INDEX_H
+
+#include <vector>
+
+
+// Bookkeeping for every object held by a PriorityBuffer: its priority, its serialized size, and
+// whether it currently lives in memory or on disk. PriorityDB keeps this in SQLite while
+// PriorityMemoryIndex keeps it in process and journals it to disk.
+//
+// Objects are identified by the 64 bit IDs handed out by PrioritySequence. Those start at 1, so a
+// hash of 0 means there is no such object.
+class PriorityIndex {
+  public:
+    virtual ~PriorityIndex() {}
+
+    virtual void Insert(const unsigned long long& priority, const unsigned long long& hash,
+                        const unsigned long long& size, const bool& on_disk=false) = 0;
+    virtual void Delete(const unsigned long long& hash) = 0;
+    virtual void Update(const unsigned long long& hash, const bool& on_disk) = 0;
+    virtual unsigned long long GetHighestHash(bool& on_disk) = 0;
+    virtual unsigned long long GetLowestMemoryHash() = 0;
+    virtual std::vector<unsigned long long> GetLowestMemoryHashes(
+            const unsigned long long& count) = 0;
+    virtual unsigned long long GetLowestDiskHash() = 0;
+    virtual bool Full() = 0;
+    virtual unsigned long long DiskBytes() = 0;
+    virtual unsigned long long MemoryBytes() = 0;
+    virtual unsigned long long Count() = 0;
+
+    // Writes between Begin() and Commit() are made durable together. Calls may nest, in which
+    // case only the outermost Commit() takes effect.
+    virtual void Begin() = 0;
+    virtual void Commit() = 0;
+};
+
+#endif
@@ -0,0 +1,372 @@
+#include "prioritymemoryindex.h"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define JOURNAL_FLUSH_INTERVAL 1024
+#define JOURNAL_COMPACT_THRESHOLD 4096
+
+
+class PriorityMemoryIndex::Impl {
+  public:
+    Impl(const unsigned long long& max_size, const std::string& path)
+            : max_size_{max_size}, journal_path_{path}, memory_bytes_{0}, disk_bytes_{0},
+              journal_records_{0}, unflushed_records_{0} {
+        if (max_size_ == 0LL) {
+            throw PriorityMemoryIndexException{"Must specify a nonzero max_size"};
+        }
+        replay_journal_();
+        compact_journal_();
+    }
+
+    ~Impl() {
+        try {
+            compact_journal_();
+        } catch (const PriorityMemoryIndexException& e) {
+            journal_.flush();
+        }
+    }
+
+    void Insert(const unsigned long long& priority, const unsigned long long& hash,
+                const unsigned long long& size, const bool& on_disk);
+    void Delete(const unsigned long long& hash);
+    void Update(const unsigned long long& hash, const bool& on_disk);
+    unsigned long long GetHighestHash(bool& on_disk);
+    unsigned long long GetLowestMemoryHash();
+    std::vector<unsigned long long> GetLowestMemoryHashes(const unsigned long long& count);
+    unsigned long long GetLowestDiskHash();
+    bool Full();
+    unsigned long long DiskBytes();
+    unsigned long long MemoryBytes();
+    unsigned long long Count();
+    void Begin();
+    void Commit();
+
+  private:
+    typedef std::multimap<unsigned long long, unsigned long long> Tier;
+
+    struct Entry {
+        unsigned long long size;
+        bool on_disk;
+        Tier::iterator position;
+    };
+
+    void insert_(const unsigned long long& priority, const unsigned long long& hash,
+                 const unsigned long long& size, const bool& on_disk);
+    bool delete_(const unsigned long long& hash);
+    bool update_(const unsigned long long& hash, const bool& on_disk);
+    Tier& tier_(const bool& on_disk);
+
+    void replay_journal_();
+    void compact_journal_();
+    void write_insert_(std::ostream& stream, const unsigned long long& priority,
+                       const unsigned long long& hash, const unsigned long long& size,
+                       const bool& on_disk);
+    void record_();
+
+    unsigned long long max_size_;
+    std::string journal_path_;
+    std::ofstream journal_;
+
+    std::unordered_map<unsigned long long, Entry> entries_;
+    Tier memory_tier_;
+    Tier disk_tier_;
+    unsigned long long memory_bytes_;
+    unsigned long long disk_bytes_;
+
+    unsigned long long journal_records_;
+    unsigned long long unflushed_records_;
+};
+
+void PriorityMemoryIndex::Impl::Insert(const unsigned long long& priority,
+                                       const unsigned long long& hash,
+                                       const unsigned long long& size, const bool& on_disk) {
+    if (hash == 0) {
+        return;
+    }
+
+    insert_(priority, hash, size, on_disk);
+    write_insert_(journal_, priority, hash, size, on_disk);
+    record_();
+}
+
+void PriorityMemoryIndex::Impl::Delete(const unsigned long long& hash) {
+    if (hash == 0) {
+        return;
+    }
+
+    if (delete_(hash)) {
+        journal_ << "D " << hash << "\n";
+        record_();
+    }
+}
+
+void PriorityMemoryIndex::Impl::Update(const unsigned long long& hash, const bool& on_disk) {
+    if (hash == 0) {
+        return;
+    }
+
+    if (update_(hash, on_disk)) {
+        journal_ << "U " << on_disk << " " << hash << "\n";
+        record_();
+    }
+}
+
+unsigned long long PriorityMemoryIndex::Impl::GetHighestHash(bool& on_disk) {
+    if (memory_tier_.empty() && disk_tier_.empty()) {
+        return 0;
+    }
+
+    // Ties go to the memory tier, matching "ORDER BY priority DESC, on_disk ASC"
+    if (disk_tier_.empty() ||
+            (!memory_tier_.empty() && memory_tier_.rbegin()->first >= disk_tier_.rbegin()->first)) {
+        on_disk = false;
+        return memory_tier_.rbegin()->second;
+    }
+    on_disk = true;
+    return disk_tier_.rbegin()->second;
+}
+
+unsigned long long PriorityMemoryIndex::Impl::GetLowestMemoryHash() {
+    if (memory_tier_.empty()) {
+        return 0;
+    }
+    return memory_tier_.begin()->second;
+}
+
+std::vector<unsigned long long> PriorityMemoryIndex::Impl::GetLowestMemoryHashes(
+        const unsigned long long& count) {
+    std::vector<unsigned long long> hashes;
+    for (auto item = memory_tier_.begin();
+            item != memory_tier_.end() && hashes.size() < count; ++item) {
+        hashes.push_back(item->second);
+    }
+    return hashes;
+}
+
+unsigned long long PriorityMemoryIndex::Impl::GetLowestDiskHash() {
+    if (disk_tier_.empty()) {
+        return 0;
+    }
+    return disk_tier_.begin()->second;
+}
+
+bool PriorityMemoryIndex::Impl::Full() {
+    return disk_bytes_ > max_size_;
+}
+
+unsigned long long PriorityMemoryIndex::Impl::DiskBytes() {
+    return disk_bytes_;
+}
+
+unsigned long long PriorityMemoryIndex::Impl::MemoryBytes() {
+    return memory_bytes_;
+}
+
+unsigned long long PriorityMemoryIndex::Impl::Count() {
+    return entries_.size();
+}
+
+// The journal is already flushed in batches of JOURNAL_FLUSH_INTERVAL records, so there is
+// nothing extra to group here
+void PriorityMemoryIndex::Impl::Begin() {}
+
+void PriorityMemoryIndex::Impl::Commit() {}
+
+void PriorityMemoryIndex::Impl::insert_(const unsigned long long& priority,
+                                        const unsigned long long& hash,
+                                        const unsigned long long& size, const bool& on_disk) {
+    delete_(hash);
+    auto position = tier_(on_disk).emplace(priority, hash);
+    entries_[hash] = Entry{size, on_disk, position};
+    (on_disk ? disk_bytes_ : memory_bytes_) += size;
+}
+
+bool PriorityMemoryIndex::Impl::delete_(const unsigned long long& hash) {
+    auto find = entries_.find(hash);
+    if (find == entries_.end()) {
+        return false;
+    }
+
+    auto& entry = find->second;
+    (entry.on_disk ? disk_bytes_ : memory_bytes_) -= entry.size;
+    tier_(entry.on_disk).erase(entry.position);
+    entries_.erase(find);
+    return true;
+}
+
+bool PriorityMemoryIndex::Impl::update_(const unsigned long long& hash, const bool& on_disk) {
+    auto find = entries_.find(hash);
+    if (find == entries_.end()) {
+        return false;
+    }
+
+    auto& entry = find->second;
+    if (entry.on_disk == on_disk) {
+        return false;
+    }
+
+    auto priority = entry.position->first;
+    tier_(entry.on_disk).erase(entry.position);
+    (entry.on_disk ? disk_bytes_ : memory_bytes_) -= entry.size;
+    entry.on_disk = on_disk;
+    entry.position = tier_(on_disk).emplace(priority, hash);
+    (entry.on_disk ? disk_bytes_ : memory_bytes_) += entry.size;
+    return true;
+}
+
+PriorityMemoryIndex::Impl::Tier& PriorityMemoryIndex::Impl::tier_(const bool& on_disk) {
+    return on_disk ? disk_tier_ : memory_tier_;
+}
+
+void PriorityMemoryIndex::Impl::replay_journal_() {
+    std::ifstream stream{journal_path_};
+    if (!stream.is_open()) {
+        return;
+    }
+
+    // A torn final record from a crash simply ends the replay
+    std::string operation;
+    while (stream >> operation) {
+        unsigned long long hash;
+        if (operation == "I") {
+            unsigned long long priority, size;
+            bool on_disk;
+            if (!(stream >> priority >> size >> on_disk >> hash)) {
+                break;
+            }
+            insert_(priority, hash, size, on_disk);
+        } else if (operation == "D") {
+            if (!(stream >> hash)) {
+                break;
+            }
+            delete_(hash);
+        } else if (operation == "U") {
+            bool on_disk;
+            if (!(stream >> on_disk >> hash)) {
+                break;
+            }
+            update_(hash, on_disk);
+        } else {
+            break;
+        }
+    }
+}
+
+void PriorityMemoryIndex::Impl::compact_journal_() {
+    // Rewrite the journal as one insert per live entry, then swap it in atomically
+    auto compact_path = journal_path_ + ".compact";
+    {
+        std::ofstream stream{compact_path, std::ios::trunc};
+        if (!stream.is_open()) {
+            throw PriorityMemoryIndexException{"Unable to open journal file"};
+        }
+        for (auto& tier : {&memory_tier_, &disk_tier_}) {
+            for (auto& item : *tier) {
+                auto& entry = entries_[item.second];
+                write_insert_(stream, item.first, item.second, entry.size, entry.on_disk);
+            }
+        }
+        if (!stream.flush()) {
+            throw PriorityMemoryIndexException{"Unable to write journal file"};
+        }
+    }
+
+    journal_.close();
+    if (std::rename(compact_path.data(), journal_path_.data()) != 0) {
+        throw PriorityMemoryIndexException{"Unable to replace journal file"};
+    }
+    journal_.clear();
+    journal_.open(journal_path_, std::ios::app);
+    if (!journal_.is_open()) {
+        throw PriorityMemoryIndexException{"Unable to open journal file"};
+    }
+    journal_records_ = entries_.size();
+    unflushed_records_ = 0;
+}
+
+void PriorityMemoryIndex::Impl::write_insert_(std::ostream& stream,
+                                              const unsigned long long& priority,
+                                              const unsigned long long& hash,
+                                              const unsigned long long& size,
+                                              const bool& on_disk) {
+    stream << "I " << priority << " " << size << " " << on_disk << " " << hash << "\n";
+}
+
+void PriorityMemoryIndex::Impl::record_() {
+    ++journal_records_;
+    if (++unflushed_records_ >= JOURNAL_FLUSH_INTERVAL) {
+        journal_.flush();
+        unflushed_records_ = 0;
+    }
+    if (journal_records_ > 2 * entries_.size() + JOURNAL_COMPACT_THRESHOLD) {
+        compact_journal_();
+    }
+}
+
+
+// Bridge
+
+PriorityMemoryIndex::PriorityMemoryIndex(const unsigned long long& max_size,
+                                         const std::string& path)
+        : pimpl_{ new Impl{max_size, path} } {}
+PriorityMemoryIndex::~PriorityMemoryIndex() {}
+
+void PriorityMemoryIndex::Insert(const unsigned long long& priority, const unsigned long long& hash,
+                                 const unsigned long long& size, const bool& on_disk) {
+    pimpl_->Insert(priority, hash, size, on_disk);
+}
+
+void PriorityMemoryIndex::Delete(const unsigned long long& hash) {
+    pimpl_->Delete(hash);
+}
+
+void PriorityMemoryIndex::Update(const unsigned long long& hash, const bool& on_disk) {
+    pimpl_->Update(hash, on_disk);
+}
+
+unsigned long long PriorityMemoryIndex::GetHighestHash(bool& on_disk) {
+    return pimpl_->GetHighestHash(on_disk);
+}
+
+unsigned long long PriorityMemoryIndex::GetLowestMemoryHash() {
+    return pimpl_->GetLowestMemoryHash();
+}
+
+std::vector<unsigned long long> PriorityMemoryIndex::GetLowestMemoryHashes(
+        const unsigned long long& count) {
+    return pimpl_->GetLowestMemoryHashes(count);
+}
+
+unsigned long long PriorityMemoryIndex::GetLowestDiskHash() {
+    return pimpl_->GetLowestDiskHash();
+}
+
+bool PriorityMemoryIndex::Full() {
+    return pimpl_->Full();
+}
+
+unsigned long long PriorityMemoryIndex::DiskBytes() {
+    return pimpl_->DiskBytes();
+}
+
+unsigned long long PriorityMemoryIndex::MemoryBytes() {
+    return pimpl_->MemoryBytes();
+}
+
+unsigned long long PriorityMemoryIndex::Count() {
+    return pimpl_->Count();
+}
+
+void PriorityMemoryIndex::Begin() {
+    pimpl_->Begin();
+}
+
+void PriorityMemoryIndex::Commit() {
+    pimpl_->Commit();
+}
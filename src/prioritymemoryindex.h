@@ -0,0 +1,56 @@
+#ifndef PRIORITY_MEMORY_INDEX_H
+#define PRIORITY_MEMORY_INDEX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "priorityindex.h"
+
+
+// In-process PriorityIndex. The memory and disk tiers are each kept in their own ordered
+// structure, and every change is appended to a journal at path. The journal is only flushed
+// every so often and on destruction, and it is replayed and compacted on construction, so a crash
+// can lose the most recent changes but never the whole index.
+class PriorityMemoryIndex : public PriorityIndex {
+  public:
+    PriorityMemoryIndex(const unsigned long long& max_size, const std::string& path);
+    ~PriorityMemoryIndex();
+
+    static std::string FileName() {
+        return "prism_data.journal";
+    }
+
+    void Insert(const unsigned long long& priority, const unsigned long long& hash,
+                const unsigned long long& size, const bool& on_disk=false) override;
+    void Delete(const unsigned long long& hash) override;
+    void Update(const unsigned long long& hash, const bool& on_disk) override;
+    unsigned long long GetHighestHash(bool& on_disk) override;
+    unsigned long long GetLowestMemoryHash() override;
+    std::vector<unsigned long long> GetLowestMemoryHashes(
+            const unsigned long long& count) override;
+    unsigned long long GetLowestDiskHash() override;
+    bool Full() override;
+    unsigned long long DiskBytes() override;
+    unsigned long long MemoryBytes() override;
+    unsigned long long Count() override;
+    void Begin() override;
+    void Commit() override;
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
+
+class PriorityMemoryIndexException : public std::exception {
+  public:
+    PriorityMemoryIndexException(const std::string& reason) : reason_{reason} {}
+    virtual const char* what() const throw() {
+        return reason_.data();
+    }
+
+  private:
+    std::string reason_;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "prioritysequence.h"
+
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#define SEQUENCE_BLOCK_SIZE 4096
+
+
+class PrioritySequence::Impl {
+  public:
+    Impl(const std::string& path) : path_{path}, next_{1}, reserved_{1} {
+        std::ifstream stream{path_};
+        unsigned long long persisted;
+        if (stream >> persisted && persisted > next_) {
+            next_ = persisted;
+            reserved_ = persisted;
+        }
+    }
+
+    ~Impl() {
+        // Give back the unused part of the block so a clean restart doesn't skip over it
+        try {
+            persist_(next_);
+        } catch (const PrioritySequenceException& e) {}
+    }
+
+    unsigned long long Next();
+
+  private:
+    void persist_(const unsigned long long& value);
+
+    std::string path_;
+    std::mutex mutex_;
+    unsigned long long next_;
+    unsigned long long reserved_;
+};
+
+unsigned long long PrioritySequence::Impl::Next() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (next_ >= reserved_) {
+        persist_(next_ + SEQUENCE_BLOCK_SIZE);
+        reserved_ = next_ + SEQUENCE_BLOCK_SIZE;
+    }
+    return next_++;
+}
+
+void PrioritySequence::Impl::persist_(const unsigned long long& value) {
+    auto temporary_path = path_ + ".tmp";
+    {
+        std::ofstream stream{temporary_path, std::ios::trunc};
+        if (!(stream << value << "\n" && stream.flush())) {
+            throw PrioritySequenceException{"Unable to write sequence file"};
+        }
+    }
+    if (std::rename(temporary_path.data(), path_.data()) != 0) {
+        throw PrioritySequenceException{"Unable to replace sequence file"};
+    }
+}
+
+
+// Bridge
+
+PrioritySequence::PrioritySequence(const std::string& path) : pimpl_{ new Impl{path} } {}
+PrioritySequence::~PrioritySequence() {}
+
+unsigned long long PrioritySequence::Next() {
+    return pimpl_->Next();
+}
@@ -0,0 +1,38 @@
+#ifndef PRIORITY_SEQUENCE_H
+#define PRIORITY_SEQUENCE_H
+
+#include <memory>
+#include <string>
+
+
+// Hands out monotonically increasing 64 bit IDs, starting at 1. IDs are reserved in blocks and
+// the end of the current block is persisted at path, so IDs are never reused across restarts and
+// the file is only rewritten once per block.
+class PrioritySequence {
+  public:
+    PrioritySequence(const std::string& path);
+    ~PrioritySequence();
+
+    static std::string FileName() {
+        return "prism_data.sequence";
+    }
+
+    unsigned long long Next();
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> pimpl_;
+};
+
+class PrioritySequenceException : public std::exception {
+  public:
+    PrioritySequenceException(const std::string& reason) : reason_{reason} {}
+    virtual const char* what() const throw() {
+        return reason_.data();
+    }
+
+  private:
+    std::string reason_;
+};
+
+#endif
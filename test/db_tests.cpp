@@ -155,9 +155,90 @@ TEST_F(DBFixture, InitialEmptyDBAfterDestructorTest) {
     EXPECT_EQ(0, response.size());
 }
 
+TEST_F(DBFixture, InitialIndicesTest) {
+    ASSERT_FALSE(fs::exists(db_path_));
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    ASSERT_TRUE(fs::exists(db_path_));
+    std::stringstream stream;
+    stream << "SELECT name FROM sqlite_master WHERE type='index' AND tbl_name='"
+           << table_name_
+           << "' ORDER BY name;";
+    auto response = execute_(stream.str());
+    ASSERT_EQ(2, response.size());
+    EXPECT_EQ(std::string{"prism_data_hash_index"}, response[0]["name"]);
+    EXPECT_EQ(std::string{"prism_data_priority_index"}, response[1]["name"]);
+}
+
+TEST_F(DBFixture, UpgradeIndicesTest) {
+    {
+        std::stringstream stream;
+        stream << "CREATE TABLE "
+               << table_name_
+               << "("
+               << "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+               << "priority UNSIGNED BIGINT NOT NULL,"
+               << "hash TEXT NOT NULL,"
+               << "size UNSIGNED BIGINT NOT NULL,"
+               << "on_disk BOOL NOT NULL"
+               << ");";
+        execute_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "INSERT INTO "
+               << table_name_
+               << "(priority, hash, size, on_disk) VALUES (1, '7', 5, 1);";
+        execute_(stream.str());
+    }
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    std::stringstream stream;
+    stream << "SELECT name FROM sqlite_master WHERE type='index' AND tbl_name='"
+           << table_name_
+           << "' ORDER BY name;";
+    auto response = execute_(stream.str());
+    ASSERT_EQ(2, response.size());
+    EXPECT_EQ(std::string{"prism_data_hash_index"}, response[0]["name"]);
+    EXPECT_EQ(std::string{"prism_data_priority_index"}, response[1]["name"]);
+    bool on_disk;
+    EXPECT_EQ(7, db.GetHighestHash(on_disk));
+    EXPECT_TRUE(on_disk);
+}
+
+TEST_F(DBFixture, UpgradeLegacyHashTest) {
+    {
+        std::stringstream stream;
+        stream << "CREATE TABLE "
+               << table_name_
+               << "("
+               << "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+               << "priority UNSIGNED BIGINT NOT NULL,"
+               << "hash TEXT NOT NULL,"
+               << "size UNSIGNED BIGINT NOT NULL,"
+               << "on_disk BOOL NOT NULL"
+               << ");";
+        execute_(stream.str());
+    }
+    {
+        std::stringstream stream;
+        stream << "INSERT INTO "
+               << table_name_
+               << "(priority, hash, size, on_disk) VALUES (2, 'hash', 5, 1), (1, '7', 10, 1);";
+        execute_(stream.str());
+    }
+    // Rows keyed by the old random string hashes can't be addressed by ID, so they're dropped
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    EXPECT_EQ(1, db.Count());
+    EXPECT_EQ(10, db.DiskBytes());
+    bool on_disk;
+    EXPECT_EQ(7, db.GetHighestHash(on_disk));
+    EXPECT_TRUE(on_disk);
+    db.Delete(7);
+    EXPECT_EQ(0, db.Count());
+}
+
 TEST_F(DBFixture, InsertEmptyHashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "", 5, false);
+    db.Insert(1, 0, 5, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -168,7 +249,7 @@ TEST_F(DBFixture, InsertEmptyHashTest) {
 
 TEST_F(DBFixture, InsertSingleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -179,14 +260,14 @@ TEST_F(DBFixture, InsertSingleTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(false, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, InsertCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -198,7 +279,7 @@ TEST_F(DBFixture, InsertCoupleTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(1, std::stoi(record["id"]));
         EXPECT_EQ(1, std::stoi(record["priority"]));
-        EXPECT_EQ(std::string{"hash"}, record["hash"]);
+        EXPECT_EQ(std::string{"1"}, record["hash"]);
         EXPECT_EQ(5, std::stoi(record["size"]));
         EXPECT_EQ(false, std::stoi(record["on_disk"]));
     }
@@ -207,7 +288,7 @@ TEST_F(DBFixture, InsertCoupleTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(2, std::stoi(record["id"]));
         EXPECT_EQ(3, std::stoi(record["priority"]));
-        EXPECT_EQ(std::string{"hashbrowns"}, record["hash"]);
+        EXPECT_EQ(std::string{"2"}, record["hash"]);
         EXPECT_EQ(10, std::stoi(record["size"]));
         EXPECT_EQ(true, std::stoi(record["on_disk"]));
     }
@@ -217,7 +298,7 @@ TEST_F(DBFixture, InsertManyTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -230,7 +311,7 @@ TEST_F(DBFixture, InsertManyTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(i + 1, std::stoi(record["id"]));
         EXPECT_EQ(i, std::stoi(record["priority"]));
-        EXPECT_EQ(std::to_string(i * i), record["hash"]);
+        EXPECT_EQ(std::to_string(i * i + 1), record["hash"]);
         EXPECT_EQ(i * 2, std::stoi(record["size"]));
         EXPECT_EQ(i % 2, std::stoi(record["on_disk"]));
     }
@@ -238,7 +319,7 @@ TEST_F(DBFixture, InsertManyTest) {
 
 TEST_F(DBFixture, DeleteNullTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -247,7 +328,7 @@ TEST_F(DBFixture, DeleteNullTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Delete("");
+    db.Delete(0);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -258,7 +339,7 @@ TEST_F(DBFixture, DeleteNullTest) {
 
 TEST_F(DBFixture, DeleteBadHashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -267,7 +348,7 @@ TEST_F(DBFixture, DeleteBadHashTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Delete("h");
+    db.Delete(99);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -278,7 +359,7 @@ TEST_F(DBFixture, DeleteBadHashTest) {
 
 TEST_F(DBFixture, DeleteSingleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -287,7 +368,7 @@ TEST_F(DBFixture, DeleteSingleTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Delete("hash");
+    db.Delete(1);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -298,8 +379,8 @@ TEST_F(DBFixture, DeleteSingleTest) {
 
 TEST_F(DBFixture, DeleteCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(2, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(2, 2, 10, true);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -308,8 +389,8 @@ TEST_F(DBFixture, DeleteCoupleTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(2, response.size());
     }
-    db.Delete("hash");
-    db.Delete("hashbrowns");
+    db.Delete(1);
+    db.Delete(2);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -322,7 +403,7 @@ TEST_F(DBFixture, DeleteManyTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
     }
     {
         std::stringstream stream;
@@ -333,7 +414,7 @@ TEST_F(DBFixture, DeleteManyTest) {
         ASSERT_EQ(number_of_records, response.size());
     }
     for (int i = 0; i < number_of_records; ++i) {
-        db.Delete(std::to_string(i * i));
+        db.Delete(i * i + 1);
         std::stringstream stream;
         stream << "SELECT * FROM "
                << table_name_
@@ -345,7 +426,7 @@ TEST_F(DBFixture, DeleteManyTest) {
 
 TEST_F(DBFixture, UpdateNullTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -354,7 +435,7 @@ TEST_F(DBFixture, UpdateNullTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("", true);
+    db.Update(0, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -365,14 +446,14 @@ TEST_F(DBFixture, UpdateNullTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(false, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateBadHashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -381,7 +462,7 @@ TEST_F(DBFixture, UpdateBadHashTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("h", true);
+    db.Update(99, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -392,14 +473,14 @@ TEST_F(DBFixture, UpdateBadHashTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(false, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateSingleFalseToTrueTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -408,7 +489,7 @@ TEST_F(DBFixture, UpdateSingleFalseToTrueTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("hash", true);
+    db.Update(1, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -419,14 +500,14 @@ TEST_F(DBFixture, UpdateSingleFalseToTrueTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(true, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateSingleTrueToFalseTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
+    db.Insert(1, 1, 5, true);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -435,7 +516,7 @@ TEST_F(DBFixture, UpdateSingleTrueToFalseTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("hash", false);
+    db.Update(1, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -446,14 +527,14 @@ TEST_F(DBFixture, UpdateSingleTrueToFalseTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(false, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateSingleFalseToFalseTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -462,7 +543,7 @@ TEST_F(DBFixture, UpdateSingleFalseToFalseTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("hash", false);
+    db.Update(1, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -473,14 +554,14 @@ TEST_F(DBFixture, UpdateSingleFalseToFalseTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(false, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateSingleTrueToTrueTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
+    db.Insert(1, 1, 5, true);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -489,7 +570,7 @@ TEST_F(DBFixture, UpdateSingleTrueToTrueTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(1, response.size());
     }
-    db.Update("hash", true);
+    db.Update(1, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -500,15 +581,15 @@ TEST_F(DBFixture, UpdateSingleTrueToTrueTest) {
     ASSERT_EQ(5, record.size());
     EXPECT_EQ(1, std::stoi(record["id"]));
     EXPECT_EQ(1, std::stoi(record["priority"]));
-    EXPECT_EQ(std::string{"hash"}, record["hash"]);
+    EXPECT_EQ(std::string{"1"}, record["hash"]);
     EXPECT_EQ(5, std::stoi(record["size"]));
     EXPECT_EQ(true, std::stoi(record["on_disk"]));
 }
 
 TEST_F(DBFixture, UpdateCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, true);
     { 
         std::stringstream stream;
         stream << "SELECT * FROM "
@@ -517,8 +598,8 @@ TEST_F(DBFixture, UpdateCoupleTest) {
         auto response = execute_(stream.str());
         ASSERT_EQ(2, response.size());
     }
-    db.Update("hash", true);
-    db.Update("hashbrowns", false);
+    db.Update(1, true);
+    db.Update(2, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -530,7 +611,7 @@ TEST_F(DBFixture, UpdateCoupleTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(1, std::stoi(record["id"]));
         EXPECT_EQ(1, std::stoi(record["priority"]));
-        EXPECT_EQ(std::string{"hash"}, record["hash"]);
+        EXPECT_EQ(std::string{"1"}, record["hash"]);
         EXPECT_EQ(5, std::stoi(record["size"]));
         EXPECT_EQ(true, std::stoi(record["on_disk"]));
     }
@@ -539,7 +620,7 @@ TEST_F(DBFixture, UpdateCoupleTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(2, std::stoi(record["id"]));
         EXPECT_EQ(3, std::stoi(record["priority"]));
-        EXPECT_EQ(std::string{"hashbrowns"}, record["hash"]);
+        EXPECT_EQ(std::string{"2"}, record["hash"]);
         EXPECT_EQ(10, std::stoi(record["size"]));
         EXPECT_EQ(false, std::stoi(record["on_disk"]));
     }
@@ -549,8 +630,8 @@ TEST_F(DBFixture, UpdateManyTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
-        db.Update(std::to_string(i * i), (i + 1) % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
+        db.Update(i * i + 1, (i + 1) % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -563,7 +644,7 @@ TEST_F(DBFixture, UpdateManyTest) {
         ASSERT_EQ(5, record.size());
         EXPECT_EQ(i + 1, std::stoi(record["id"]));
         EXPECT_EQ(i, std::stoi(record["priority"]));
-        EXPECT_EQ(std::to_string(i * i), record["hash"]);
+        EXPECT_EQ(std::to_string(i * i + 1), record["hash"]);
         EXPECT_EQ(i * 2, std::stoi(record["size"]));
         EXPECT_EQ((i + 1) % 2, std::stoi(record["on_disk"]));
     }
@@ -578,7 +659,7 @@ TEST_F(DBFixture, HighestHashNoneFalseOnDiskTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(0, response.size());
     bool on_disk = false;
-    EXPECT_TRUE(db.GetHighestHash(on_disk).empty());
+    EXPECT_EQ(0, db.GetHighestHash(on_disk));
     EXPECT_FALSE(on_disk);
 }
 
@@ -591,13 +672,13 @@ TEST_F(DBFixture, HighestHashNoneTrueOnDiskTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(0, response.size());
     bool on_disk = true;
-    EXPECT_TRUE(db.GetHighestHash(on_disk).empty());
+    EXPECT_EQ(0, db.GetHighestHash(on_disk));
     EXPECT_TRUE(on_disk);
 }
 
 TEST_F(DBFixture, HighestHashSingleInMemoryTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -606,19 +687,19 @@ TEST_F(DBFixture, HighestHashSingleInMemoryTest) {
     ASSERT_EQ(1, response.size());
     {
         bool on_disk = true;
-        EXPECT_EQ(std::string{"hash"}, db.GetHighestHash(on_disk));
+        EXPECT_EQ(1, db.GetHighestHash(on_disk));
         EXPECT_FALSE(on_disk);
     }
     {
         bool on_disk = false;
-        EXPECT_EQ(std::string{"hash"}, db.GetHighestHash(on_disk));
+        EXPECT_EQ(1, db.GetHighestHash(on_disk));
         EXPECT_FALSE(on_disk);
     }
 }
 
 TEST_F(DBFixture, HighestHashSingleOnDiskTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
+    db.Insert(1, 1, 5, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -627,20 +708,20 @@ TEST_F(DBFixture, HighestHashSingleOnDiskTest) {
     ASSERT_EQ(1, response.size());
     {
         bool on_disk = true;
-        EXPECT_EQ(std::string{"hash"}, db.GetHighestHash(on_disk));
+        EXPECT_EQ(1, db.GetHighestHash(on_disk));
         EXPECT_TRUE(on_disk);
     }
     {
         bool on_disk = false;
-        EXPECT_EQ(std::string{"hash"}, db.GetHighestHash(on_disk));
+        EXPECT_EQ(1, db.GetHighestHash(on_disk));
         EXPECT_TRUE(on_disk);
     }
 }
 
 TEST_F(DBFixture, HighestHashCoupleInMemoryTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(3, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, true);
+    db.Insert(3, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -648,14 +729,14 @@ TEST_F(DBFixture, HighestHashCoupleInMemoryTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
     bool on_disk;
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetHighestHash(on_disk));
+    EXPECT_EQ(2, db.GetHighestHash(on_disk));
     EXPECT_FALSE(on_disk);
 }
 
 TEST_F(DBFixture, HighestHashCoupleOnDiskTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -663,14 +744,14 @@ TEST_F(DBFixture, HighestHashCoupleOnDiskTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
     bool on_disk;
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetHighestHash(on_disk));
+    EXPECT_EQ(2, db.GetHighestHash(on_disk));
     EXPECT_TRUE(on_disk);
 }
 
 TEST_F(DBFixture, HighestHashCoupleTiedTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(1, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, true);
+    db.Insert(1, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -678,14 +759,14 @@ TEST_F(DBFixture, HighestHashCoupleTiedTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
     bool on_disk;
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetHighestHash(on_disk));
+    EXPECT_EQ(2, db.GetHighestHash(on_disk));
     EXPECT_FALSE(on_disk);
 }
 
 TEST_F(DBFixture, HighestHashCoupleTiedAgainTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(1, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(1, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
@@ -693,7 +774,7 @@ TEST_F(DBFixture, HighestHashCoupleTiedAgainTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
     bool on_disk;
-    EXPECT_EQ(std::string{"hash"}, db.GetHighestHash(on_disk));
+    EXPECT_EQ(1, db.GetHighestHash(on_disk));
     EXPECT_FALSE(on_disk);
 }
 
@@ -701,7 +782,7 @@ TEST_F(DBFixture, HighestHashManyInMemoryTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, (i + 1) % 2);
+        db.Insert(i, i * i + 1, i * 2, (i + 1) % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -710,7 +791,7 @@ TEST_F(DBFixture, HighestHashManyInMemoryTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
     bool on_disk;
-    EXPECT_EQ(std::to_string(99 * 99), db.GetHighestHash(on_disk));
+    EXPECT_EQ(99 * 99 + 1, db.GetHighestHash(on_disk));
     EXPECT_FALSE(on_disk);
 }
 
@@ -718,7 +799,7 @@ TEST_F(DBFixture, HighestHashManyOnDiskTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -727,7 +808,7 @@ TEST_F(DBFixture, HighestHashManyOnDiskTest) {
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
     bool on_disk;
-    EXPECT_EQ(std::to_string(99 * 99), db.GetHighestHash(on_disk));
+    EXPECT_EQ(99 * 99 + 1, db.GetHighestHash(on_disk));
     EXPECT_TRUE(on_disk);
 }
 
@@ -739,103 +820,103 @@ TEST_F(DBFixture, LowestMemoryHashNoneTest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(0, response.size());
-    EXPECT_TRUE(db.GetLowestMemoryHash().empty());
+    EXPECT_EQ(0, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashNoneAgainTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
+    db.Insert(1, 1, 5, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(1, response.size());
-    EXPECT_TRUE(db.GetLowestMemoryHash().empty());
+    EXPECT_EQ(0, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashSingleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(1, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestMemoryHash());
+    EXPECT_EQ(1, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashCoupleATest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestMemoryHash());
+    EXPECT_EQ(1, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashCoupleBTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(3, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, true);
+    db.Insert(3, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetLowestMemoryHash());
+    EXPECT_EQ(2, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashCoupleCTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestMemoryHash());
+    EXPECT_EQ(1, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashCoupleDTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(3, "hash", 5, false);
-    db.Insert(1, "hashbrowns", 10, false);
+    db.Insert(3, 1, 5, false);
+    db.Insert(1, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetLowestMemoryHash());
+    EXPECT_EQ(2, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashCoupleETest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, true);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_TRUE(db.GetLowestMemoryHash().empty());
+    EXPECT_EQ(0, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashManyATest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -843,14 +924,14 @@ TEST_F(DBFixture, LowestMemoryHashManyATest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
-    EXPECT_EQ(std::to_string(0), db.GetLowestMemoryHash());
+    EXPECT_EQ(1, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestMemoryHashManyBTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, (i + 1) % 2);
+        db.Insert(i, i * i + 1, i * 2, (i + 1) % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -858,7 +939,7 @@ TEST_F(DBFixture, LowestMemoryHashManyBTest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
-    EXPECT_EQ(std::to_string(1), db.GetLowestMemoryHash());
+    EXPECT_EQ(2, db.GetLowestMemoryHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashNoneTest) {
@@ -869,103 +950,103 @@ TEST_F(DBFixture, LowestDiskHashNoneTest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(0, response.size());
-    EXPECT_TRUE(db.GetLowestDiskHash().empty());
+    EXPECT_EQ(0, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashNoneAgainTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
+    db.Insert(1, 1, 5, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(1, response.size());
-    EXPECT_TRUE(db.GetLowestDiskHash().empty());
+    EXPECT_EQ(0, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashSingleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
+    db.Insert(1, 1, 5, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(1, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestDiskHash());
+    EXPECT_EQ(1, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashCoupleATest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(3, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, true);
+    db.Insert(3, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestDiskHash());
+    EXPECT_EQ(1, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashCoupleBTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetLowestDiskHash());
+    EXPECT_EQ(2, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashCoupleCTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, true);
-    db.Insert(3, "hashbrowns", 10, true);
+    db.Insert(1, 1, 5, true);
+    db.Insert(3, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hash"}, db.GetLowestDiskHash());
+    EXPECT_EQ(1, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashCoupleDTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(3, "hash", 5, true);
-    db.Insert(1, "hashbrowns", 10, true);
+    db.Insert(3, 1, 5, true);
+    db.Insert(1, 2, 10, true);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_EQ(std::string{"hashbrowns"}, db.GetLowestDiskHash());
+    EXPECT_EQ(2, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashCoupleETest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", 5, false);
-    db.Insert(3, "hashbrowns", 10, false);
+    db.Insert(1, 1, 5, false);
+    db.Insert(3, 2, 10, false);
     std::stringstream stream;
     stream << "SELECT * FROM "
            << table_name_
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(2, response.size());
-    EXPECT_TRUE(db.GetLowestDiskHash().empty());
+    EXPECT_EQ(0, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashManyATest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, i % 2);
+        db.Insert(i, i * i + 1, i * 2, i % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -973,14 +1054,14 @@ TEST_F(DBFixture, LowestDiskHashManyATest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
-    EXPECT_EQ(std::to_string(1), db.GetLowestDiskHash());
+    EXPECT_EQ(2, db.GetLowestDiskHash());
 }
 
 TEST_F(DBFixture, LowestDiskHashManyBTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
     auto number_of_records = 100;
     for (int i = 0; i < number_of_records; ++i) {
-        db.Insert(i, std::to_string(i * i), i * 2, (i + 1) % 2);
+        db.Insert(i, i * i + 1, i * 2, (i + 1) % 2);
     }
     std::stringstream stream;
     stream << "SELECT * FROM "
@@ -988,7 +1069,27 @@ TEST_F(DBFixture, LowestDiskHashManyBTest) {
            << ";";
     auto response = execute_(stream.str());
     ASSERT_EQ(number_of_records, response.size());
-    EXPECT_EQ(std::to_string(0), db.GetLowestDiskHash());
+    EXPECT_EQ(1, db.GetLowestDiskHash());
+}
+
+TEST_F(DBFixture, LowestMemoryHashesNoneTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5, true);
+    EXPECT_TRUE(db.GetLowestMemoryHashes(10).empty());
+}
+
+TEST_F(DBFixture, LowestMemoryHashesManyTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    auto number_of_records = 100;
+    for (int i = 0; i < number_of_records; ++i) {
+        db.Insert(number_of_records - i, i + 1, i * 2, i % 2);
+    }
+    auto hashes = db.GetLowestMemoryHashes(10);
+    ASSERT_EQ(10, hashes.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(number_of_records - 1 - 2 * i, hashes[i]);
+    }
+    EXPECT_EQ(number_of_records / 2, db.GetLowestMemoryHashes(number_of_records).size());
 }
 
 TEST_F(DBFixture, FullEmptyTest) { // Yeah this test name is silly
@@ -998,73 +1099,108 @@ TEST_F(DBFixture, FullEmptyTest) { // Yeah this test name is silly
 
 TEST_F(DBFixture, FullInMemoryUnderTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE - 1, false);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE - 1, false);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullInMemoryExactTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE, false);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE, false);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullInMemoryOverTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE + 1, false);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE + 1, false);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullOnDiskUnderTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE - 1, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE - 1, true);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullOnDiskExactTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE, true);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullOnDiskOverTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE + 1, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE + 1, true);
     EXPECT_TRUE(db.Full());
 }
 
 TEST_F(DBFixture, FullMixedOverCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE, true);
     ASSERT_FALSE(db.Full());
-    db.Insert(3, "hashbrowns", 1, false);
+    db.Insert(3, 2, 1, false);
     EXPECT_FALSE(db.Full());
 }
 
 TEST_F(DBFixture, FullOnDiskOverCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE, true);
     ASSERT_FALSE(db.Full());
-    db.Insert(3, "hashbrowns", 1, true);
+    db.Insert(3, 2, 1, true);
     EXPECT_TRUE(db.Full());
 }
 
 TEST_F(DBFixture, FullOnDiskDeleteCoupleTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    db.Insert(1, "hash", DEFAULT_MAX_SIZE, true);
+    db.Insert(1, 1, DEFAULT_MAX_SIZE, true);
     ASSERT_FALSE(db.Full());
-    db.Insert(3, "hashbrowns", 1, true);
+    db.Insert(3, 2, 1, true);
     ASSERT_TRUE(db.Full());
-    db.Delete("hashbrowns");
+    db.Delete(2);
     EXPECT_FALSE(db.Full());
 }
 
-TEST_F(DBFixture, DeletedDBThrowInsertTest) {
+TEST_F(DBFixture, TransactionTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    std::stringstream stream;
+    stream << "SELECT * FROM "
+           << table_name_
+           << ";";
+    db.Begin();
+    for (int i = 0; i < 100; ++i) {
+        db.Insert(i, i + 1, 5, false);
+    }
+    // Another connection can't see the rows until they're committed
+    EXPECT_EQ(0, execute_(stream.str()).size());
+    EXPECT_EQ(100, db.Count());
+    db.Commit();
+    EXPECT_EQ(100, execute_(stream.str()).size());
+}
+
+TEST_F(DBFixture, NestedTransactionTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    std::stringstream stream;
+    stream << "SELECT * FROM "
+           << table_name_
+           << ";";
+    db.Begin();
+    db.Insert(1, 1, 5, false);
+    db.Begin();
+    db.Insert(2, 2, 5, false);
+    db.Commit();
+    EXPECT_EQ(0, execute_(stream.str()).size());
+    db.Commit();
+    EXPECT_EQ(2, execute_(stream.str()).size());
+    db.Commit();
+    db.Insert(3, 3, 5, false);
+    EXPECT_EQ(3, execute_(stream.str()).size());
+}
+
+TEST_F(DBFixture, DroppedTableThrowInsertTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    drop_table_();
     bool thrown = false;
     try {
-        db.Insert(1, "hash", 5, false);
+        db.Insert(1, 1, 5, false);
     } catch (const PriorityDBException& e) {
         thrown = true;
         EXPECT_EQ(std::string{"no such table: prism_data"},
@@ -1073,13 +1209,12 @@ TEST_F(DBFixture, DeletedDBThrowInsertTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowDeleteTest) {
+TEST_F(DBFixture, DroppedTableThrowDeleteTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    drop_table_();
     bool thrown = false;
     try {
-        db.Delete("hash");
+        db.Delete(1);
     } catch (const PriorityDBException& e) {
         thrown = true;
         EXPECT_EQ(std::string{"no such table: prism_data"},
@@ -1088,13 +1223,12 @@ TEST_F(DBFixture, DeletedDBThrowDeleteTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowUpdateTest) {
+TEST_F(DBFixture, DroppedTableThrowUpdateTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    drop_table_();
     bool thrown = false;
     try {
-        db.Update("hash", true);
+        db.Update(1, true);
     } catch (const PriorityDBException& e) {
         thrown = true;
         EXPECT_EQ(std::string{"no such table: prism_data"},
@@ -1103,10 +1237,9 @@ TEST_F(DBFixture, DeletedDBThrowUpdateTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowGetHighestHashTest) {
+TEST_F(DBFixture, DroppedTableThrowGetHighestHashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    drop_table_();
     bool thrown = false;
     try {
         bool on_disk;
@@ -1119,10 +1252,9 @@ TEST_F(DBFixture, DeletedDBThrowGetHighestHashTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowGetLowestMemoryHashTest) {
+TEST_F(DBFixture, DroppedTableThrowGetLowestMemoryHashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    drop_table_();
     bool thrown = false;
     try {
         db.GetLowestMemoryHash();
@@ -1134,10 +1266,9 @@ TEST_F(DBFixture, DeletedDBThrowGetLowestMemoryHashTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowGetLowestDiskashTest) {
+TEST_F(DBFixture, DroppedTableThrowGetLowestDiskashTest) {
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
+    drop_table_();
     bool thrown = false;
     try {
         db.GetLowestDiskHash();
@@ -1149,17 +1280,86 @@ TEST_F(DBFixture, DeletedDBThrowGetLowestDiskashTest) {
     EXPECT_TRUE(thrown);
 }
 
-TEST_F(DBFixture, DeletedDBThrowFullTest) {
+TEST_F(DBFixture, DroppedTableFullTest) {
+    // Full() is answered from the running totals, so it never touches the table
     PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
-    fs::remove(db_path_);
-    ASSERT_FALSE(fs::exists(db_path_));
-    bool thrown = false;
-    try {
-        db.Full();
-    } catch (const PriorityDBException& e) {
-        thrown = true;
-        EXPECT_EQ(std::string{"no such table: prism_data"},
-                  std::string{e.what()});
+    db.Insert(1, 1, DEFAULT_MAX_SIZE + 1, true);
+    drop_table_();
+    EXPECT_TRUE(db.Full());
+}
+
+TEST_F(DBFixture, TotalsEmptyTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    EXPECT_EQ(0, db.DiskBytes());
+    EXPECT_EQ(0, db.MemoryBytes());
+    EXPECT_EQ(0, db.Count());
+}
+
+TEST_F(DBFixture, TotalsInsertTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5, false);
+    db.Insert(2, 2, 10, true);
+    db.Insert(3, 3, 20, true);
+    EXPECT_EQ(30, db.DiskBytes());
+    EXPECT_EQ(5, db.MemoryBytes());
+    EXPECT_EQ(3, db.Count());
+}
+
+TEST_F(DBFixture, TotalsDeleteTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5, false);
+    db.Insert(2, 2, 10, true);
+    db.Delete(1);
+    EXPECT_EQ(10, db.DiskBytes());
+    EXPECT_EQ(0, db.MemoryBytes());
+    EXPECT_EQ(1, db.Count());
+    db.Delete(2);
+    EXPECT_EQ(0, db.DiskBytes());
+    EXPECT_EQ(0, db.MemoryBytes());
+    EXPECT_EQ(0, db.Count());
+}
+
+TEST_F(DBFixture, TotalsDeleteBadHashTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5, false);
+    db.Delete(99);
+    EXPECT_EQ(0, db.DiskBytes());
+    EXPECT_EQ(5, db.MemoryBytes());
+    EXPECT_EQ(1, db.Count());
+}
+
+TEST_F(DBFixture, TotalsUpdateTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5, false);
+    db.Insert(2, 2, 10, true);
+    db.Update(1, true);
+    EXPECT_EQ(15, db.DiskBytes());
+    EXPECT_EQ(0, db.MemoryBytes());
+    db.Update(1, true);
+    EXPECT_EQ(15, db.DiskBytes());
+    EXPECT_EQ(0, db.MemoryBytes());
+    db.Update(2, false);
+    EXPECT_EQ(5, db.DiskBytes());
+    EXPECT_EQ(10, db.MemoryBytes());
+    EXPECT_EQ(2, db.Count());
+}
+
+TEST_F(DBFixture, TotalsReloadTest) {
+    {
+        PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+        db.Insert(1, 1, 5, false);
+        db.Insert(2, 2, 10, true);
+        db.Insert(3, 3, 20, true);
     }
-    EXPECT_TRUE(thrown);
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    EXPECT_EQ(30, db.DiskBytes());
+    EXPECT_EQ(5, db.MemoryBytes());
+    EXPECT_EQ(3, db.Count());
+}
+
+TEST_F(DBFixture, TotalsLargeTest) {
+    PriorityDB db{DEFAULT_MAX_SIZE, db_string_};
+    db.Insert(1, 1, 5000000000LL, true);
+    EXPECT_EQ(5000000000LL, db.DiskBytes());
+    EXPECT_TRUE(db.Full());
 }
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <map>
+#include <sstream>
 #include <string>
 
 #include <boost/filesystem.hpp>
@@ -64,6 +65,16 @@ class DBFixture : public FSFixture {
         return response;
     }
 
+    // PriorityDB holds its connection open, so removing the database file underneath it goes
+    // unnoticed. Dropping the table is what breaks it.
+    void drop_table_() {
+        std::stringstream stream;
+        stream << "DROP TABLE "
+               << table_name_
+               << ";";
+        execute_(stream.str());
+    }
+
     fs::path db_path_;
     std::string db_string_;
     std::string table_name_;
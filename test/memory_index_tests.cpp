@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "fsfixture.h"
+#include "prioritymemoryindex.h"
+
+#define DEFAULT_MAX_SIZE 100000000LL
+
+
+namespace fs = boost::filesystem;
+
+class MemoryIndexFixture : public FSFixture {
+  protected:
+    virtual void SetUp() {
+        FSFixture::SetUp();
+        fs::create_directory(buffer_path_);
+        journal_path_ = buffer_path_ / fs::path{PriorityMemoryIndex::FileName()};
+        journal_string_ = journal_path_.native();
+    }
+
+    fs::path journal_path_;
+    std::string journal_string_;
+};
+
+TEST_F(MemoryIndexFixture, ConstructIndexTest) {
+    ASSERT_FALSE(fs::exists(journal_path_));
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    EXPECT_TRUE(fs::exists(journal_path_));
+    EXPECT_EQ(0, index.Count());
+}
+
+TEST_F(MemoryIndexFixture, ConstructZeroSpaceTest) {
+    bool thrown = false;
+    try {
+        PriorityMemoryIndex index{0LL, journal_string_};
+    } catch (const PriorityMemoryIndexException& e) {
+        thrown = true;
+        EXPECT_EQ(std::string{"Must specify a nonzero max_size"},
+                  std::string{e.what()});
+    }
+    EXPECT_TRUE(thrown);
+}
+
+TEST_F(MemoryIndexFixture, ConstructThrowTest) {
+    bool thrown = false;
+    try {
+        PriorityMemoryIndex index{DEFAULT_MAX_SIZE, (buffer_path_ / fs::path{"missing"} /
+                                                     fs::path{"journal"}).native()};
+    } catch (const PriorityMemoryIndexException& e) {
+        thrown = true;
+        EXPECT_EQ(std::string{"Unable to open journal file"},
+                  std::string{e.what()});
+    }
+    EXPECT_TRUE(thrown);
+}
+
+TEST_F(MemoryIndexFixture, InsertEmptyHashTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    index.Insert(1, 0, 5, false);
+    EXPECT_EQ(0, index.Count());
+}
+
+TEST_F(MemoryIndexFixture, HighestHashTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    bool on_disk;
+    EXPECT_EQ(0, index.GetHighestHash(on_disk));
+    index.Insert(1, 1, 5, false);
+    index.Insert(3, 2, 10, true);
+    index.Insert(2, 3, 10, false);
+    EXPECT_EQ(2, index.GetHighestHash(on_disk));
+    EXPECT_TRUE(on_disk);
+    index.Delete(2);
+    EXPECT_EQ(3, index.GetHighestHash(on_disk));
+    EXPECT_FALSE(on_disk);
+}
+
+TEST_F(MemoryIndexFixture, HighestHashTiedTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    index.Insert(1, 1, 5, true);
+    index.Insert(1, 2, 10, false);
+    bool on_disk;
+    EXPECT_EQ(2, index.GetHighestHash(on_disk));
+    EXPECT_FALSE(on_disk);
+}
+
+TEST_F(MemoryIndexFixture, LowestHashTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    EXPECT_EQ(0, index.GetLowestMemoryHash());
+    EXPECT_EQ(0, index.GetLowestDiskHash());
+    for (int i = 0; i < 100; ++i) {
+        index.Insert(100 - i, i + 1, 1, i % 2);
+    }
+    EXPECT_EQ(99, index.GetLowestMemoryHash());
+    EXPECT_EQ(100, index.GetLowestDiskHash());
+}
+
+TEST_F(MemoryIndexFixture, LowestMemoryHashesTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    EXPECT_TRUE(index.GetLowestMemoryHashes(10).empty());
+    for (int i = 0; i < 100; ++i) {
+        index.Insert(100 - i, i + 1, 1, i % 2);
+    }
+    auto hashes = index.GetLowestMemoryHashes(10);
+    ASSERT_EQ(10, hashes.size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(99 - 2 * i, hashes[i]);
+    }
+    EXPECT_EQ(50, index.GetLowestMemoryHashes(100).size());
+}
+
+TEST_F(MemoryIndexFixture, UpdateTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    index.Insert(1, 1, 5, false);
+    index.Insert(2, 2, 10, false);
+    index.Update(1, true);
+    EXPECT_EQ(2, index.GetLowestMemoryHash());
+    EXPECT_EQ(1, index.GetLowestDiskHash());
+    EXPECT_EQ(5, index.DiskBytes());
+    EXPECT_EQ(10, index.MemoryBytes());
+    index.Update(99, true);
+    EXPECT_EQ(2, index.Count());
+}
+
+TEST_F(MemoryIndexFixture, FullTest) {
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    index.Insert(1, 1, DEFAULT_MAX_SIZE, true);
+    index.Insert(2, 3, 1, false);
+    EXPECT_FALSE(index.Full());
+    index.Insert(3, 2, 1, true);
+    EXPECT_TRUE(index.Full());
+    index.Delete(2);
+    EXPECT_FALSE(index.Full());
+}
+
+TEST_F(MemoryIndexFixture, ReplayTest) {
+    {
+        PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+        for (int i = 0; i < 100; ++i) {
+            index.Insert(i, i + 1, i * 2, i % 2);
+        }
+        for (int i = 0; i < 100; i += 3) {
+            index.Delete(i + 1);
+        }
+        index.Update(99, true);
+    }
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    EXPECT_EQ(66, index.Count());
+    bool on_disk;
+    EXPECT_EQ(99, index.GetHighestHash(on_disk));
+    EXPECT_TRUE(on_disk);
+    EXPECT_EQ(2, index.GetLowestDiskHash());
+    EXPECT_EQ(3, index.GetLowestMemoryHash());
+}
+
+TEST_F(MemoryIndexFixture, ReplayTornJournalTest) {
+    {
+        std::ofstream stream{journal_string_};
+        stream << "I 5 10 1 1\n"
+               << "I 7 10 0 2\n"
+               << "D";
+    }
+    PriorityMemoryIndex index{DEFAULT_MAX_SIZE, journal_string_};
+    EXPECT_EQ(2, index.Count());
+    EXPECT_EQ(10, index.DiskBytes());
+    EXPECT_EQ(10, index.MemoryBytes());
+}
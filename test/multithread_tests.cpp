@@ -4,6 +4,7 @@
 #include <memory>
 #include <random>
 #include <thread>
+#include <vector>
 
 #include "fsfixture.h"
 #include "priority.pb.h"
@@ -119,6 +120,35 @@ TEST_F(FSFixture, RandomMultithreadedWithBlockingBadFuzzTest) {
     EXPECT_LT(end - start, std::chrono::seconds(5));
 }
 
+void push_batch(PriorityBuffer<PriorityMessage>& buffer, int messages, int batch_size) {
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    for (int i = 0; i < messages; i += batch_size) {
+        std::vector<std::unique_ptr<PriorityMessage>> batch;
+        for (int j = i; j < messages && j < i + batch_size; ++j) {
+            auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+            message->set_priority(distribution(generator));
+            batch.push_back(std::move(message));
+        }
+        buffer.PushBatch(std::move(batch));
+    }
+}
+
+TEST_F(FSFixture, PushBatchMultipleConsumersTest) {
+    PriorityBuffer<PriorityMessage> buffer{get_priority};
+
+    std::vector<std::thread> pull_threads;
+    for (int i = 0; i < 4; ++i) {
+        pull_threads.emplace_back(pull_block, std::ref(buffer), NUMBER_MESSAGES_IN_TEST / 4);
+    }
+    std::thread push_thread(push_batch, std::ref(buffer), NUMBER_MESSAGES_IN_TEST, 100);
+
+    push_thread.join();
+    for (auto& pull_thread : pull_threads) {
+        pull_thread.join();
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     GOOGLE_PROTOBUF_VERIFY_VERSION;
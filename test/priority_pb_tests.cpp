@@ -3,6 +3,7 @@
 #include <memory>
 #include <random>
 #include <string>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -150,6 +151,126 @@ TEST_F(FSFixture, DiskDumpSomePriorityTest) {
     EXPECT_EQ(number_of_files_(), NUMBER_MESSAGES_IN_TEST - number_of_popped);
 }
 
+TEST_F(FSFixture, PushBatchPriorityTest) {
+    PriorityBuffer<PriorityMessage> buffer{get_priority};
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    std::vector<std::unique_ptr<PriorityMessage>> messages;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+        message->set_priority(distribution(generator));
+        messages.push_back(std::move(message));
+    }
+    buffer.PushBatch(std::move(messages));
+    EXPECT_EQ(number_of_files_(), NUMBER_MESSAGES_IN_TEST - DEFAULT_MAX_MEMORY_SIZE);
+
+    unsigned long long priority = 100LL;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = buffer.Pop();
+        ASSERT_NE(nullptr, message);
+        EXPECT_GE(priority, message->priority());
+        priority = message->priority();
+    }
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
+TEST_F(FSFixture, PushBatchMaxSizePriorityTest) {
+    PriorityBuffer<PriorityMessage> buffer{get_priority, NUMBER_MESSAGES_IN_TEST,
+                                           DEFAULT_MAX_MEMORY_SIZE};
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    for (int batch = 0; batch < 10; ++batch) {
+        std::vector<std::unique_ptr<PriorityMessage>> messages;
+        for (int i = 0; i < NUMBER_MESSAGES_IN_TEST / 10; ++i) {
+            auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+            message->set_priority(distribution(generator));
+            messages.push_back(std::move(message));
+        }
+        buffer.PushBatch(std::move(messages));
+    }
+    unsigned long long priority = 100LL;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST / 2 + DEFAULT_MAX_MEMORY_SIZE; ++i) {
+        auto message = buffer.Pop();
+        ASSERT_NE(nullptr, message);
+        EXPECT_GE(priority, message->priority());
+        priority = message->priority();
+    }
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
+TEST_F(FSFixture, PushBatchEmptyTest) {
+    PriorityBuffer<PriorityMessage> buffer{get_priority};
+    buffer.PushBatch(std::vector<std::unique_ptr<PriorityMessage>>{});
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
+TEST_F(FSFixture, MemoryIndexRandomPriorityTest) {
+    PriorityBuffer<PriorityMessage, PriorityMemoryIndex> buffer{get_priority};
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+        auto priority = distribution(generator);
+        message->set_priority(priority);
+        EXPECT_TRUE(message->IsInitialized());
+        EXPECT_EQ(priority, message->priority());
+        buffer.Push(std::move(message));
+    }
+    unsigned long long priority = 100LL;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = buffer.Pop();
+        EXPECT_TRUE(message->IsInitialized());
+        EXPECT_GE(priority, message->priority());
+        priority = message->priority();
+    }
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
+TEST_F(FSFixture, MemoryIndexMaxSizePriorityTest) {
+    PriorityBuffer<PriorityMessage, PriorityMemoryIndex> buffer{get_priority,
+                                                                NUMBER_MESSAGES_IN_TEST,
+                                                                DEFAULT_MAX_MEMORY_SIZE};
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+        message->set_priority(distribution(generator));
+        buffer.Push(std::move(message));
+    }
+    unsigned long long priority = 100LL;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST / 2 + DEFAULT_MAX_MEMORY_SIZE; ++i) {
+        auto message = buffer.Pop();
+        EXPECT_TRUE(message->IsInitialized());
+        EXPECT_GE(priority, message->priority());
+        priority = message->priority();
+    }
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
+TEST_F(FSFixture, MemoryIndexRestartPriorityTest) {
+    std::random_device generator;
+    std::uniform_int_distribution<unsigned long long> distribution(0, 100LL);
+    {
+        PriorityBuffer<PriorityMessage, PriorityMemoryIndex> buffer{get_priority};
+        for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+            auto message = std::unique_ptr<PriorityMessage>{ new PriorityMessage{} };
+            message->set_priority(distribution(generator));
+            buffer.Push(std::move(message));
+        }
+    }
+    EXPECT_EQ(number_of_files_(), NUMBER_MESSAGES_IN_TEST);
+
+    PriorityBuffer<PriorityMessage, PriorityMemoryIndex> buffer{get_priority};
+    unsigned long long priority = 100LL;
+    for (int i = 0; i < NUMBER_MESSAGES_IN_TEST; ++i) {
+        auto message = buffer.Pop();
+        ASSERT_NE(nullptr, message);
+        EXPECT_GE(priority, message->priority());
+        priority = message->priority();
+    }
+    EXPECT_EQ(nullptr, buffer.Pop());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     GOOGLE_PROTOBUF_VERIFY_VERSION;
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include "fsfixture.h"
+#include "prioritysequence.h"
+
+
+namespace fs = boost::filesystem;
+
+class SequenceFixture : public FSFixture {
+  protected:
+    virtual void SetUp() {
+        FSFixture::SetUp();
+        fs::create_directory(buffer_path_);
+        sequence_path_ = buffer_path_ / fs::path{PrioritySequence::FileName()};
+        sequence_string_ = sequence_path_.native();
+    }
+
+    fs::path sequence_path_;
+    std::string sequence_string_;
+};
+
+TEST_F(SequenceFixture, FirstIDTest) {
+    PrioritySequence sequence{sequence_string_};
+    EXPECT_EQ(1, sequence.Next());
+    EXPECT_TRUE(fs::exists(sequence_path_));
+}
+
+TEST_F(SequenceFixture, MonotonicTest) {
+    PrioritySequence sequence{sequence_string_};
+    auto previous = sequence.Next();
+    for (int i = 0; i < 10000; ++i) {
+        auto next = sequence.Next();
+        EXPECT_EQ(previous + 1, next);
+        previous = next;
+    }
+}
+
+TEST_F(SequenceFixture, RestartTest) {
+    unsigned long long last = 0;
+    {
+        PrioritySequence sequence{sequence_string_};
+        for (int i = 0; i < 10; ++i) {
+            last = sequence.Next();
+        }
+    }
+    PrioritySequence sequence{sequence_string_};
+    EXPECT_EQ(last + 1, sequence.Next());
+}
+
+TEST_F(SequenceFixture, CrashTest) {
+    // Simulate a crash by copying the sequence file before the sequence is torn down
+    unsigned long long last = 0;
+    auto copy_path = buffer_path_ / fs::path{"copy"};
+    {
+        PrioritySequence sequence{sequence_string_};
+        for (int i = 0; i < 10; ++i) {
+            last = sequence.Next();
+        }
+        fs::copy_file(sequence_path_, copy_path);
+    }
+    fs::remove(sequence_path_);
+    fs::rename(copy_path, sequence_path_);
+    PrioritySequence sequence{sequence_string_};
+    EXPECT_LT(last, sequence.Next());
+}
+
+TEST_F(SequenceFixture, ThrowTest) {
+    bool thrown = false;
+    try {
+        PrioritySequence sequence{(buffer_path_ / fs::path{"missing"} /
+                                   fs::path{"sequence"}).native()};
+        sequence.Next();
+    } catch (const PrioritySequenceException& e) {
+        thrown = true;
+        EXPECT_EQ(std::string{"Unable to write sequence file"},
+                  std::string{e.what()});
+    }
+    EXPECT_TRUE(thrown);
+}